@@ -24,9 +24,38 @@ KrustyBusIFace::KrustyBusIFace(ComponentId_t id, Params& params)
 
   // read the params
   ClockFreq = params.find<std::string>("clockFreq", "1GHz");
+  InjectWidth = params.find<unsigned>("injectWidth", 0);
+  EventDriven = params.find<bool>("eventDriven", false);
 
   // register the clock
-  registerClock(ClockFreq, new Clock::Handler<KrustyBusIFace>(this,&KrustyBusIFace::clock));
+  clockHandler = new Clock::Handler2<KrustyBusIFace,&KrustyBusIFace::clock>(this);
+  clockTC = registerClock(ClockFreq, clockHandler);
+  clockOn = true;
+  issueCycle = 0;
+  issued = 0;
+
+  // the clock is woken through a self link so that it is never
+  // re-registered from within another clock handler
+  wakeLink = configureSelfLink("wakeClock", "1ps",
+                               new Event::Handler2<KrustyBusIFace,&KrustyBusIFace::handleWake>(this));
+  wakePending = false;
+
+  // sampled simulation: bypassed packets are delivered through a self
+  // link after the latency fitted from the detailed windows
+  SampleDetailed = params.find<uint64_t>("sampleDetailed", 100000);
+  SampleFF = params.find<uint64_t>("sampleFastForward", 0);
+  if( SampleFF > 0 && SampleDetailed == 0 )
+    out.fatal(CALL_INFO, -1, "Error: sampleDetailed must be non-zero when fast-forwarding\n");
+  psTC = getTimeConverter("1ps");
+  deliverLink = configureSelfLink("bypassDeliver", "1ps",
+                                  new Event::Handler2<KrustyBusIFace,&KrustyBusIFace::handleDeliver>(this));
+  for( unsigned i=0; isPortConnected("bypass" + std::to_string(i)); i++ ){
+    bypassPorts.push_back(configureLink("bypass" + std::to_string(i), "1ps",
+                                        new Event::Handler2<KrustyBusIFace,&KrustyBusIFace::handleBypass>(this)));
+  }
+
+  BypassPkts = registerStatistic<uint64_t>("BypassPkts");
+  ModelError = registerStatistic<uint64_t>("ModelError");
 
   // load the SimpleNetwork interfaces
   iFace = loadUserSubComponent<SST::Interfaces::SimpleNetwork>("iface",
@@ -49,8 +78,9 @@ KrustyBusIFace::KrustyBusIFace(ComponentId_t id, Params& params)
   }
 
   iFace->setNotifyOnReceive(
-    new SST::Interfaces::SimpleNetwork::Handler<KrustyBusIFace>(this,
-                                                         &KrustyBusIFace::msgNotify));
+    new SST::Interfaces::SimpleNetwork::Handler2<KrustyBusIFace,&KrustyBusIFace::msgNotify>(this));
+  iFace->setNotifyOnSend(
+    new SST::Interfaces::SimpleNetwork::Handler2<KrustyBusIFace,&KrustyBusIFace::spaceNotify>(this));
 
   initBroadcastSent = false;
   numDest = 0;
@@ -81,6 +111,20 @@ void KrustyBusIFace::init(unsigned int phase){
       req->src = iFace->getEndpointID();
       req->givePayload(ev);
       iFace->sendInitData(req);
+
+      // tell each bypass peer which network endpoint we are
+      for( auto L : bypassPorts ){
+        KrustyBusEvent *bev = new KrustyBusEvent();
+        bev->setSrc(iFace->getEndpointID());
+        L->sendUntimedData(bev);
+      }
+    }
+  }
+
+  for( auto L : bypassPorts ){
+    while( SST::Event *bev = L->recvUntimedData() ){
+      bypassLinks[static_cast<KrustyBusEvent*>(bev)->getSrc()] = L;
+      delete bev;
     }
   }
 
@@ -123,6 +167,19 @@ bool KrustyBusIFace::msgNotify(int vn){
     out.verbose(CALL_INFO, 9, 0,
                  "%s received message from %lld\n",
                  getName().c_str(), (long long)(ev->getSrc()));
+    syncModels();
+
+    // packets from a bypass peer are credited back to it and must not
+    // overtake its earlier bypassed packets that are still pending
+    if( SampleFF > 0 && bypassLinks.count(ev->getSrc()) ){
+      sendCredit(ev);
+      auto it = rxQ.find(ev->getSrc());
+      if( it != rxQ.end() ){
+        it->second.push_back(KrustyBusRx(ev, true));
+        delete req;
+        return true;
+      }
+    }
     (*msgHandler)(ev);  // <========== this is where we hand off the event payload to our local logic
     delete req;
     delete ev;
@@ -139,11 +196,40 @@ void KrustyBusIFace::send(KrustyBusEvent* event, int destination){
     out.fatal(CALL_INFO, -1, "Error: source ID is; Opc=%d; SourceName=%s; destination=%d\n",
               event->getOpcode(), getName().c_str(), destination);
   }
+  event->setSendTime(getCurrentSimTime(psTC));
+  syncModels();
+
+  // fast-forward windows skip Merlin when there is a direct link to the
+  // peer.  Packets to the peer stay on Merlin until everything queued or
+  // in flight ahead of them has arrived, so they cannot be overtaken.
+  // Until a latency model to the peer has been fitted there is nothing
+  // to stand in for Merlin
+  auto bp = bypassLinks.find(destination);
+  uint64_t Lat = 0;
+  if( SampleFF > 0 && bp != bypassLinks.end() ){
+    if( inFastForward() && sendQ.empty() && merlinOut.count(destination) == 0 &&
+        predictLatency(destination, Lat) ){
+      event->setNetLatency(Lat);
+      BypassPkts->addData(1);
+      bp->second->send(event);
+      return;
+    }
+    merlinOut[destination]++;
+  }
+
   SST::Interfaces::SimpleNetwork::Request *req = new SST::Interfaces::SimpleNetwork::Request();
   req->dest = destination;
   req->src = iFace->getEndpointID();
   req->givePayload(event);
-  sendQ.push(req);
+
+  // an idle event-driven NIC injects immediately rather than
+  // waiting for the next clock edge
+  if( EventDriven && sendQ.empty() && issue(req) ){
+    return;
+  }
+
+  sendQ.push_back(req);
+  wakeClock();
 }
 
 int KrustyBusIFace::getNumDestinations(){
@@ -154,17 +240,217 @@ SST::Interfaces::SimpleNetwork::nid_t KrustyBusIFace::getAddress(){
   return iFace->getEndpointID();
 }
 
+bool KrustyBusIFace::canIssue(){
+  SimTime_t cycle = getCurrentSimTime(clockTC);
+  if( cycle != issueCycle ){
+    issueCycle = cycle;
+    issued = 0;
+  }
+  return (InjectWidth == 0) || (issued < InjectWidth);
+}
+
+bool KrustyBusIFace::issue(SST::Interfaces::SimpleNetwork::Request *req){
+  if( !canIssue() )
+    return false;
+  if( iFace->spaceToSend(0,256) && iFace->send(req,0) ){
+    issued++;
+    out.verbose(CALL_INFO, 10, 0, "%s flushed a message to the network\n",
+                 getName().c_str());
+    return true;
+  }
+  return false;
+}
+
+void KrustyBusIFace::wakeClock(){
+  if( !clockOn && !wakePending ){
+    wakePending = true;
+    wakeLink->send(new KrustyBusEvent());
+  }
+}
+
+void KrustyBusIFace::handleWake(SST::Event *ev){
+  delete ev;
+  wakePending = false;
+  if( !clockOn ){
+    reregisterClock(clockTC, clockHandler);
+    clockOn = true;
+  }
+}
+
+bool KrustyBusIFace::spaceNotify(int vn){
+  if( !sendQ.empty() )
+    wakeClock();
+  return true;
+}
+
+bool KrustyBusIFace::inFastForward(uint64_t &Window){
+  SimTime_t cycle = getCurrentSimTime(clockTC);
+  Window = (SampleFF == 0) ? 0 : cycle / (SampleDetailed + SampleFF);
+  return (SampleFF > 0) && ((cycle % (SampleDetailed + SampleFF)) >= SampleDetailed);
+}
+
+bool KrustyBusIFace::inFastForward(){
+  uint64_t Window = 0;
+  return inFastForward(Window);
+}
+
+void KrustyBusIFace::syncModels(){
+  if( SampleFF == 0 )
+    return;
+
+  // a window's samples are complete once its detailed part has ended;
+  // this runs on every send and receive, so a quiet NIC catches up on
+  // its next packet without mixing windows
+  uint64_t Window = 0;
+  bool FF = inFastForward(Window);
+  uint64_t Error = 0;
+  for( auto &M : netModels ){
+    if( M.second.Samples > 0 && (FF || M.second.Window != Window) ){
+      if( M.second.refit(Error) )
+        ModelError->addData(Error);
+    }
+  }
+}
+
+bool KrustyBusIFace::predictLatency(SST::Interfaces::SimpleNetwork::nid_t Dest, uint64_t &Lat){
+  auto it = netModels.find(Dest);
+  if( it == netModels.end() || !it->second.Valid )
+    return false;
+  Lat = it->second.Fit;
+  return true;
+}
+
+void KrustyBusIFace::handleBypass(SST::Event *ev){
+  KrustyBusEvent *kev = static_cast<KrustyBusEvent*>(ev);
+  SST::Interfaces::SimpleNetwork::nid_t Src = kev->getSrc();
+  syncModels();
+
+  // a credit: one of our packets to the peer has left Merlin, after
+  // the latency carried in the data field
+  if( kev->getOpcode() == KrustyBusEvent::KB_UNK ){
+    auto it = merlinOut.find(Src);
+    if( it != merlinOut.end() && --it->second == 0 )
+      merlinOut.erase(it);
+
+    // only packets sent and credited within the current detailed window
+    // are sampled; Merlin traffic in a fast-forward window is skipped
+    uint64_t Window = 0;
+    if( !inFastForward(Window) ){
+      SimTime_t Sent = clockTC->convertFromCoreTime(psTC->convertToCoreTime(kev->getSendTime()));
+      if( Sent / (SampleDetailed + SampleFF) == Window )
+        netModels[Src].sample(kev->getData(), Window);
+    }
+    delete ev;
+    return;
+  }
+
+  // hold the packet until its modeled latency has elapsed, never
+  // earlier than the bypassed packets from the same peer ahead of it
+  SimTime_t Now = getCurrentSimTime(psTC);
+  SimTime_t When = std::max(kev->getSendTime() + kev->getNetLatency(), Now);
+  auto last = lastDeliver.find(Src);
+  if( last != lastDeliver.end() )
+    When = std::max(When, last->second);
+  lastDeliver[Src] = When;
+
+  rxQ[Src].push_back(KrustyBusRx(kev, false));
+  KrustyBusEvent *mark = new KrustyBusEvent();
+  mark->setSrc(Src);
+  deliverLink->send(When - Now, mark);
+}
+
+void KrustyBusIFace::handleDeliver(SST::Event *ev){
+  SST::Interfaces::SimpleNetwork::nid_t Src = static_cast<KrustyBusEvent*>(ev)->getSrc();
+  delete ev;
+
+  // bypassed packets from a peer become ready in the order they arrived
+  for( auto &R : rxQ[Src] ){
+    if( !R.Ready ){
+      R.Ready = true;
+      break;
+    }
+  }
+  drainRx(Src);
+}
+
+void KrustyBusIFace::drainRx(SST::Interfaces::SimpleNetwork::nid_t Src){
+  auto it = rxQ.find(Src);
+  if( it == rxQ.end() )
+    return;
+  while( !it->second.empty() && it->second.front().Ready ){
+    KrustyBusEvent *kev = it->second.front().Ev;
+    it->second.pop_front();
+    out.verbose(CALL_INFO, 9, 0,
+                 "%s delivered held message from %lld\n",
+                 getName().c_str(), (long long)(Src));
+    (*msgHandler)(kev);
+    delete kev;
+  }
+  if( it->second.empty() )
+    rxQ.erase(it);
+}
+
+void KrustyBusIFace::sendCredit(KrustyBusEvent *ev){
+  // credits are KB_UNK packets, which never appear as bus traffic
+  KrustyBusEvent *cev = new KrustyBusEvent();
+  cev->setOpcode(KrustyBusEvent::KB_UNK);
+  cev->setSrc(iFace->getEndpointID());
+  cev->setSendTime(ev->getSendTime());
+  cev->setData(getCurrentSimTime(psTC) - ev->getSendTime());
+  bypassLinks[ev->getSrc()]->send(cev);
+}
+
+void KrustyBusIFace::serialize_order(SST::Core::Serialization::serializer &ser){
+  KrustyBusNicAPI::serialize_order(ser);
+  ser &out;
+  ser &iFace;
+  ser &msgHandler;
+  ser &initBroadcastSent;
+  ser &numDest;
+  ser &sendQ;
+  ser &endpointTypes;
+  ser &ClockFreq;
+  ser &InjectWidth;
+  ser &EventDriven;
+  ser &clockTC;
+  ser &clockHandler;
+  ser &clockOn;
+  ser &wakeLink;
+  ser &wakePending;
+  ser &issueCycle;
+  ser &issued;
+  ser &SampleDetailed;
+  ser &SampleFF;
+  ser &psTC;
+  ser &deliverLink;
+  ser &bypassPorts;
+  ser &bypassLinks;
+  ser &netModels;
+  ser &merlinOut;
+  ser &rxQ;
+  ser &lastDeliver;
+  ser &BypassPkts;
+  ser &ModelError;
+}
+
 bool KrustyBusIFace::clock(Cycle_t cycle){
-  while( !sendQ.empty() ){
-    if( iFace->spaceToSend(0,256) && iFace->send(sendQ.front(),0)) {
-      sendQ.pop();
-      out.verbose(CALL_INFO, 10, 0, "%s flushed a message to the network\n",
-                   getName().c_str());
+  bool stalled = false;
+  while( !sendQ.empty() && canIssue() ){
+    if( issue(sendQ.front()) ){
+      sendQ.pop_front();
     }else{
+      stalled = true;
       break;
     }
   }
 
+  // gate the clock off while there is nothing left to inject or the
+  // network is out of credits; send() and spaceNotify() re-enable it
+  if( sendQ.empty() || stalled ){
+    clockOn = false;
+    return true;
+  }
+
   return false;
 }
 
@@ -179,9 +465,38 @@ KrustyBusMemIFace::KrustyBusMemIFace(ComponentId_t id, Params& params)
 
   // read the params
   ClockFreq = params.find<std::string>("clockFreq", "1GHz");
+  InjectWidth = params.find<unsigned>("injectWidth", 0);
+  EventDriven = params.find<bool>("eventDriven", false);
 
   // register the clock
-  registerClock(ClockFreq, new Clock::Handler<KrustyBusMemIFace>(this,&KrustyBusMemIFace::clock));
+  clockHandler = new Clock::Handler2<KrustyBusMemIFace,&KrustyBusMemIFace::clock>(this);
+  clockTC = registerClock(ClockFreq, clockHandler);
+  clockOn = true;
+  issueCycle = 0;
+  issued = 0;
+
+  // the clock is woken through a self link so that it is never
+  // re-registered from within another clock handler
+  wakeLink = configureSelfLink("wakeClock", "1ps",
+                               new Event::Handler2<KrustyBusMemIFace,&KrustyBusMemIFace::handleWake>(this));
+  wakePending = false;
+
+  // sampled simulation: bypassed packets are delivered through a self
+  // link after the latency fitted from the detailed windows
+  SampleDetailed = params.find<uint64_t>("sampleDetailed", 100000);
+  SampleFF = params.find<uint64_t>("sampleFastForward", 0);
+  if( SampleFF > 0 && SampleDetailed == 0 )
+    out.fatal(CALL_INFO, -1, "Error: sampleDetailed must be non-zero when fast-forwarding\n");
+  psTC = getTimeConverter("1ps");
+  deliverLink = configureSelfLink("bypassDeliver", "1ps",
+                                  new Event::Handler2<KrustyBusMemIFace,&KrustyBusMemIFace::handleDeliver>(this));
+  for( unsigned i=0; isPortConnected("bypass" + std::to_string(i)); i++ ){
+    bypassPorts.push_back(configureLink("bypass" + std::to_string(i), "1ps",
+                                        new Event::Handler2<KrustyBusMemIFace,&KrustyBusMemIFace::handleBypass>(this)));
+  }
+
+  BypassPkts = registerStatistic<uint64_t>("BypassPkts");
+  ModelError = registerStatistic<uint64_t>("ModelError");
 
   // load the SimpleNetwork interfaces
   iFace = loadUserSubComponent<SST::Interfaces::SimpleNetwork>("iface",
@@ -204,8 +519,9 @@ KrustyBusMemIFace::KrustyBusMemIFace(ComponentId_t id, Params& params)
   }
 
   iFace->setNotifyOnReceive(
-    new SST::Interfaces::SimpleNetwork::Handler<KrustyBusMemIFace>(this,
-                                                         &KrustyBusMemIFace::msgNotify));
+    new SST::Interfaces::SimpleNetwork::Handler2<KrustyBusMemIFace,&KrustyBusMemIFace::msgNotify>(this));
+  iFace->setNotifyOnSend(
+    new SST::Interfaces::SimpleNetwork::Handler2<KrustyBusMemIFace,&KrustyBusMemIFace::spaceNotify>(this));
 
   initBroadcastSent = false;
   numDest = 0;
@@ -236,6 +552,20 @@ void KrustyBusMemIFace::init(unsigned int phase){
       req->src = iFace->getEndpointID();
       req->givePayload(ev);
       iFace->sendInitData(req);
+
+      // tell each bypass peer which network endpoint we are
+      for( auto L : bypassPorts ){
+        KrustyBusEvent *bev = new KrustyBusEvent();
+        bev->setSrc(iFace->getEndpointID());
+        L->sendUntimedData(bev);
+      }
+    }
+  }
+
+  for( auto L : bypassPorts ){
+    while( SST::Event *bev = L->recvUntimedData() ){
+      bypassLinks[static_cast<KrustyBusEvent*>(bev)->getSrc()] = L;
+      delete bev;
     }
   }
 
@@ -278,6 +608,19 @@ bool KrustyBusMemIFace::msgNotify(int vn){
     out.verbose(CALL_INFO, 9, 0,
                  "%s received message from %lld\n",
                  getName().c_str(), (long long)(ev->getSrc()));
+    syncModels();
+
+    // packets from a bypass peer are credited back to it and must not
+    // overtake its earlier bypassed packets that are still pending
+    if( SampleFF > 0 && bypassLinks.count(ev->getSrc()) ){
+      sendCredit(ev);
+      auto it = rxQ.find(ev->getSrc());
+      if( it != rxQ.end() ){
+        it->second.push_back(KrustyBusRx(ev, true));
+        delete req;
+        return true;
+      }
+    }
     (*msgHandler)(ev);  // <========== this is where we hand off the event payload to our local logic
     delete req;
     delete ev;
@@ -294,11 +637,40 @@ void KrustyBusMemIFace::send(KrustyBusEvent* event, int destination){
     out.fatal(CALL_INFO, -1, "Error: source ID is; Opc=%d; SourceName=%s; destination=%d\n",
               event->getOpcode(), getName().c_str(), destination);
   }
+  event->setSendTime(getCurrentSimTime(psTC));
+  syncModels();
+
+  // fast-forward windows skip Merlin when there is a direct link to the
+  // peer.  Packets to the peer stay on Merlin until everything queued or
+  // in flight ahead of them has arrived, so they cannot be overtaken.
+  // Until a latency model to the peer has been fitted there is nothing
+  // to stand in for Merlin
+  auto bp = bypassLinks.find(destination);
+  uint64_t Lat = 0;
+  if( SampleFF > 0 && bp != bypassLinks.end() ){
+    if( inFastForward() && sendQ.empty() && merlinOut.count(destination) == 0 &&
+        predictLatency(destination, Lat) ){
+      event->setNetLatency(Lat);
+      BypassPkts->addData(1);
+      bp->second->send(event);
+      return;
+    }
+    merlinOut[destination]++;
+  }
+
   SST::Interfaces::SimpleNetwork::Request *req = new SST::Interfaces::SimpleNetwork::Request();
   req->dest = destination;
   req->src = iFace->getEndpointID();
   req->givePayload(event);
-  sendQ.push(req);
+
+  // an idle event-driven NIC injects immediately rather than
+  // waiting for the next clock edge
+  if( EventDriven && sendQ.empty() && issue(req) ){
+    return;
+  }
+
+  sendQ.push_back(req);
+  wakeClock();
 }
 
 int KrustyBusMemIFace::getNumDestinations(){
@@ -309,17 +681,217 @@ SST::Interfaces::SimpleNetwork::nid_t KrustyBusMemIFace::getAddress(){
   return iFace->getEndpointID();
 }
 
+bool KrustyBusMemIFace::canIssue(){
+  SimTime_t cycle = getCurrentSimTime(clockTC);
+  if( cycle != issueCycle ){
+    issueCycle = cycle;
+    issued = 0;
+  }
+  return (InjectWidth == 0) || (issued < InjectWidth);
+}
+
+bool KrustyBusMemIFace::issue(SST::Interfaces::SimpleNetwork::Request *req){
+  if( !canIssue() )
+    return false;
+  if( iFace->spaceToSend(0,256) && iFace->send(req,0) ){
+    issued++;
+    out.verbose(CALL_INFO, 10, 0, "%s flushed a message to the network\n",
+                 getName().c_str());
+    return true;
+  }
+  return false;
+}
+
+void KrustyBusMemIFace::wakeClock(){
+  if( !clockOn && !wakePending ){
+    wakePending = true;
+    wakeLink->send(new KrustyBusEvent());
+  }
+}
+
+void KrustyBusMemIFace::handleWake(SST::Event *ev){
+  delete ev;
+  wakePending = false;
+  if( !clockOn ){
+    reregisterClock(clockTC, clockHandler);
+    clockOn = true;
+  }
+}
+
+bool KrustyBusMemIFace::spaceNotify(int vn){
+  if( !sendQ.empty() )
+    wakeClock();
+  return true;
+}
+
+bool KrustyBusMemIFace::inFastForward(uint64_t &Window){
+  SimTime_t cycle = getCurrentSimTime(clockTC);
+  Window = (SampleFF == 0) ? 0 : cycle / (SampleDetailed + SampleFF);
+  return (SampleFF > 0) && ((cycle % (SampleDetailed + SampleFF)) >= SampleDetailed);
+}
+
+bool KrustyBusMemIFace::inFastForward(){
+  uint64_t Window = 0;
+  return inFastForward(Window);
+}
+
+void KrustyBusMemIFace::syncModels(){
+  if( SampleFF == 0 )
+    return;
+
+  // a window's samples are complete once its detailed part has ended;
+  // this runs on every send and receive, so a quiet NIC catches up on
+  // its next packet without mixing windows
+  uint64_t Window = 0;
+  bool FF = inFastForward(Window);
+  uint64_t Error = 0;
+  for( auto &M : netModels ){
+    if( M.second.Samples > 0 && (FF || M.second.Window != Window) ){
+      if( M.second.refit(Error) )
+        ModelError->addData(Error);
+    }
+  }
+}
+
+bool KrustyBusMemIFace::predictLatency(SST::Interfaces::SimpleNetwork::nid_t Dest, uint64_t &Lat){
+  auto it = netModels.find(Dest);
+  if( it == netModels.end() || !it->second.Valid )
+    return false;
+  Lat = it->second.Fit;
+  return true;
+}
+
+void KrustyBusMemIFace::handleBypass(SST::Event *ev){
+  KrustyBusEvent *kev = static_cast<KrustyBusEvent*>(ev);
+  SST::Interfaces::SimpleNetwork::nid_t Src = kev->getSrc();
+  syncModels();
+
+  // a credit: one of our packets to the peer has left Merlin, after
+  // the latency carried in the data field
+  if( kev->getOpcode() == KrustyBusEvent::KB_UNK ){
+    auto it = merlinOut.find(Src);
+    if( it != merlinOut.end() && --it->second == 0 )
+      merlinOut.erase(it);
+
+    // only packets sent and credited within the current detailed window
+    // are sampled; Merlin traffic in a fast-forward window is skipped
+    uint64_t Window = 0;
+    if( !inFastForward(Window) ){
+      SimTime_t Sent = clockTC->convertFromCoreTime(psTC->convertToCoreTime(kev->getSendTime()));
+      if( Sent / (SampleDetailed + SampleFF) == Window )
+        netModels[Src].sample(kev->getData(), Window);
+    }
+    delete ev;
+    return;
+  }
+
+  // hold the packet until its modeled latency has elapsed, never
+  // earlier than the bypassed packets from the same peer ahead of it
+  SimTime_t Now = getCurrentSimTime(psTC);
+  SimTime_t When = std::max(kev->getSendTime() + kev->getNetLatency(), Now);
+  auto last = lastDeliver.find(Src);
+  if( last != lastDeliver.end() )
+    When = std::max(When, last->second);
+  lastDeliver[Src] = When;
+
+  rxQ[Src].push_back(KrustyBusRx(kev, false));
+  KrustyBusEvent *mark = new KrustyBusEvent();
+  mark->setSrc(Src);
+  deliverLink->send(When - Now, mark);
+}
+
+void KrustyBusMemIFace::handleDeliver(SST::Event *ev){
+  SST::Interfaces::SimpleNetwork::nid_t Src = static_cast<KrustyBusEvent*>(ev)->getSrc();
+  delete ev;
+
+  // bypassed packets from a peer become ready in the order they arrived
+  for( auto &R : rxQ[Src] ){
+    if( !R.Ready ){
+      R.Ready = true;
+      break;
+    }
+  }
+  drainRx(Src);
+}
+
+void KrustyBusMemIFace::drainRx(SST::Interfaces::SimpleNetwork::nid_t Src){
+  auto it = rxQ.find(Src);
+  if( it == rxQ.end() )
+    return;
+  while( !it->second.empty() && it->second.front().Ready ){
+    KrustyBusEvent *kev = it->second.front().Ev;
+    it->second.pop_front();
+    out.verbose(CALL_INFO, 9, 0,
+                 "%s delivered held message from %lld\n",
+                 getName().c_str(), (long long)(Src));
+    (*msgHandler)(kev);
+    delete kev;
+  }
+  if( it->second.empty() )
+    rxQ.erase(it);
+}
+
+void KrustyBusMemIFace::sendCredit(KrustyBusEvent *ev){
+  // credits are KB_UNK packets, which never appear as bus traffic
+  KrustyBusEvent *cev = new KrustyBusEvent();
+  cev->setOpcode(KrustyBusEvent::KB_UNK);
+  cev->setSrc(iFace->getEndpointID());
+  cev->setSendTime(ev->getSendTime());
+  cev->setData(getCurrentSimTime(psTC) - ev->getSendTime());
+  bypassLinks[ev->getSrc()]->send(cev);
+}
+
+void KrustyBusMemIFace::serialize_order(SST::Core::Serialization::serializer &ser){
+  KrustyBusNicAPI::serialize_order(ser);
+  ser &out;
+  ser &iFace;
+  ser &msgHandler;
+  ser &initBroadcastSent;
+  ser &numDest;
+  ser &sendQ;
+  ser &endpointTypes;
+  ser &ClockFreq;
+  ser &InjectWidth;
+  ser &EventDriven;
+  ser &clockTC;
+  ser &clockHandler;
+  ser &clockOn;
+  ser &wakeLink;
+  ser &wakePending;
+  ser &issueCycle;
+  ser &issued;
+  ser &SampleDetailed;
+  ser &SampleFF;
+  ser &psTC;
+  ser &deliverLink;
+  ser &bypassPorts;
+  ser &bypassLinks;
+  ser &netModels;
+  ser &merlinOut;
+  ser &rxQ;
+  ser &lastDeliver;
+  ser &BypassPkts;
+  ser &ModelError;
+}
+
 bool KrustyBusMemIFace::clock(Cycle_t cycle){
-  while( !sendQ.empty() ){
-    if( iFace->spaceToSend(0,256) && iFace->send(sendQ.front(),0)) {
-      sendQ.pop();
-      out.verbose(CALL_INFO, 10, 0, "%s flushed a message to the network\n",
-                   getName().c_str());
+  bool stalled = false;
+  while( !sendQ.empty() && canIssue() ){
+    if( issue(sendQ.front()) ){
+      sendQ.pop_front();
     }else{
+      stalled = true;
       break;
     }
   }
 
+  // gate the clock off while there is nothing left to inject or the
+  // network is out of credits; send() and spaceNotify() re-enable it
+  if( sendQ.empty() || stalled ){
+    clockOn = false;
+    return true;
+  }
+
   return false;
 }
 
@@ -335,25 +907,507 @@ KrustyMem::KrustyMem(ComponentId_t id, Params& params)
 
   // retrieve the parameters
   std::string ClockFreq   = params.find<std::string>("clockFreq", "1GHz");
+  BulkChunk = params.find<uint64_t>("bulkChunk", 64);
+  BulkDepth = params.find<unsigned>("bulkDepth", 8);
+  if( BulkChunk == 0 || BulkDepth == 0 )
+    out.fatal(CALL_INFO, -1, "Error: bulkChunk and bulkDepth must be non-zero\n");
+  nextBulk = 1;
+  nextSeq = 0;
+
+  // Register the clock handler; the time converter is handed to the
+  // StandardMem backends when the regions are loaded
+  clockTC = registerClock(ClockFreq,
+                          new Clock::Handler2<KrustyMem, &KrustyMem::clock>(this));
 
   // load the subcomponent
   Nic = loadUserSubComponent<KrustyBusNicAPI>("network");
   if( !Nic)
     out.fatal(CALL_INFO, -1, "Error: no KrustyBusNicAPI object loaded into KrustyMem\n");
-  Nic->setMsgHandler(new Event::Handler<KrustyMem>(this, &KrustyMem::handleMessage));
+  Nic->setMsgHandler(new Event::Handler2<KrustyMem, &KrustyMem::handleMessage>(this));
+
+  // load the memory regions
+  parseRegions(params);
+
+  // register the statistics
+  BulkOps     = registerStatistic<uint64_t>("BulkOps");
+  BulkLatency = registerStatistic<uint64_t>("BulkLatency");
 
   // Tell the simulation not to end until we signal completion
   registerAsPrimaryComponent();
   primaryComponentDoNotEndSim();
-
-  // Register the clock handler
-  registerClock(ClockFreq,
-                new Clock::Handler<KrustyMem>(this, &KrustyMem::clock));
 }
 
 KrustyMem::~KrustyMem(){
 }
 
-void KrustyMem::handleMessage(SST::Event *ev);
+void KrustyMem::parseRegions(Params& params){
+  unsigned numRegions = params.find<unsigned>("numRegions", 1);
+  if( numRegions == 0 )
+    out.fatal(CALL_INFO, -1, "Error: KrustyMem requires at least one memory region\n");
+
+  SubComponentSlotInfo *memSlots = getSubComponentSlotInfo("memory");
+  if( !memSlots )
+    out.fatal(CALL_INFO, -1, "Error: no StandardMem objects loaded into KrustyMem\n");
+
+  for( unsigned i=0; i<numRegions; i++ ){
+    std::string Name = "region" + std::to_string(i);
+    Params regionParams = params.get_scoped_params(Name);
+
+    KrustyMemRegion R;
+    R.Base      = regionParams.find<uint64_t>("base", 0);
+    uint64_t Sz = regionParams.find<uint64_t>("size", 0);
+    R.Type      = regionParams.find<std::string>("type", "DRAM");
+    R.Latency   = regionParams.find<unsigned>("latency", 0);
+    R.Bandwidth = regionParams.find<uint64_t>("bandwidth", 0);
+    R.Credits   = 0;
+
+    if( Sz == 0 ){
+      R.End = std::numeric_limits<uint64_t>::max();
+    }else{
+      R.End = R.Base + Sz - 1;
+      if( R.End < R.Base )
+        out.fatal(CALL_INFO, -1, "Error: %s wraps the address space\n", Name.c_str());
+    }
+
+    if( !memSlots->isPopulated(i) )
+      out.fatal(CALL_INFO, -1, "Error: no StandardMem object loaded into KrustyMem memory slot %u\n", i);
+    R.Mem = memSlots->create<SST::Interfaces::StandardMem>(i, ComponentInfo::SHARE_NONE, clockTC,
+              new SST::Interfaces::StandardMem::Handler2<KrustyMem, &KrustyMem::handleMemResp>(this));
+    if( !R.Mem )
+      out.fatal(CALL_INFO, -1, "Error: could not load the StandardMem object for %s\n", Name.c_str());
+
+    R.ReadReqs      = registerStatistic<uint64_t>("ReadReqs", Name);
+    R.WriteReqs     = registerStatistic<uint64_t>("WriteReqs", Name);
+    R.FlushReqs     = registerStatistic<uint64_t>("FlushReqs", Name);
+    R.BytesRead     = registerStatistic<uint64_t>("BytesRead", Name);
+    R.BytesWritten  = registerStatistic<uint64_t>("BytesWritten", Name);
+    R.ReqLatency    = registerStatistic<uint64_t>("Latency", Name);
+
+    out.verbose(CALL_INFO, 4, 0, "%s: %s [0x%llx, 0x%llx] latency=%u bandwidth=%lluB/cycle\n",
+                Name.c_str(), R.Type.c_str(),
+                (unsigned long long)(R.Base), (unsigned long long)(R.End),
+                R.Latency, (unsigned long long)(R.Bandwidth));
+
+    Regions.push_back(R);
+  }
+
+  // sort the table by base address so lookups can binary search it
+  std::sort(Regions.begin(), Regions.end(),
+            [](const KrustyMemRegion& a, const KrustyMemRegion& b){ return a.Base < b.Base; });
+  for( unsigned i=0; i<Regions.size(); i++ ){
+    if( i > 0 && Regions[i].Base <= Regions[i-1].End )
+      out.fatal(CALL_INFO, -1, "Error: KrustyMem region at 0x%llx overlaps region at 0x%llx\n",
+                (unsigned long long)(Regions[i].Base), (unsigned long long)(Regions[i-1].Base));
+    RegionBases.push_back(Regions[i].Base);
+  }
+}
+
+bool KrustyMem::findRegion(uint64_t Addr, uint64_t Size, unsigned &Region){
+  auto it = std::upper_bound(RegionBases.begin(), RegionBases.end(), Addr);
+  if( it == RegionBases.begin() )
+    return false;
+  unsigned Idx = (unsigned)(it - RegionBases.begin()) - 1;
+
+  // the entire request must fall within a single region
+  uint64_t Last = Addr + (Size ? Size - 1 : 0);
+  if( Last < Addr || Last > Regions[Idx].End )
+    return false;
+
+  Region = Idx;
+  return true;
+}
+
+void KrustyMem::init(unsigned int phase){
+  Nic->init(phase);
+  for( auto &R : Regions )
+    R.Mem->init(phase);
+}
+
+void KrustyMem::setup(){
+  Nic->setup();
+  for( auto &R : Regions )
+    R.Mem->setup();
+}
+
+void KrustyMem::finish(){
+  for( auto &R : Regions )
+    R.Mem->finish();
+}
+
+void KrustyMem::serialize_order(SST::Core::Serialization::serializer &ser){
+  Component::serialize_order(ser);
+  ser &out;
+  ser &clockTC;
+  ser &BulkChunk;
+  ser &BulkDepth;
+  ser &Nic;
+  ser &Regions;
+  ser &RegionBases;
+  ser &outstanding;
+  ser &fenceQ;
+  ser &inflight;
+  ser &nextSeq;
+  ser &bulkOps;
+  ser &nextBulk;
+  ser &BulkOps;
+  ser &BulkLatency;
+}
+
+void KrustyMem::handleMessage(SST::Event *ev){
+  KrustyBusEvent *kev = static_cast<KrustyBusEvent*>(ev);
+
+  KrustyMemReq R;
+  R.Opcode  = kev->getOpcode();
+  R.Size    = kev->getSize();
+  R.Addr    = kev->getAddr();
+  R.Data    = kev->getData();
+  R.Len     = R.Size;
+  R.Index   = kev->getIndex();
+  R.Src     = kev->getSrc();
+  R.Region  = 0;
+  R.Arrival = getCurrentSimTime(clockTC);
+  R.Ready   = R.Arrival;
+  R.Seq     = nextSeq++;
+  R.Bulk    = 0;
+  R.Stage   = KM_STAGE_HOST;
+  R.Unit    = 0;
+  R.Target  = 0;
+
+  out.verbose(CALL_INFO, 9, 0, "Received opcode=%d addr=0x%llx size=%d from %lld\n",
+              R.Opcode, (unsigned long long)(R.Addr), R.Size, (long long)(R.Src));
+
+  // everything but a fence is tracked until its response is sent
+  if( R.Opcode != KrustyBusEvent::KB_FENCE )
+    inflight[R.Src].insert(R.Seq);
+
+  switch( R.Opcode ){
+  case KrustyBusEvent::KB_FENCE:
+    fenceQ.push_back(R);
+    return;
+  case KrustyBusEvent::KB_READ:
+  case KrustyBusEvent::KB_WRITE:
+    if( R.Size > sizeof(uint64_t) )
+      out.fatal(CALL_INFO, -1, "Error: request size %d exceeds the KrustyBusEvent payload\n", R.Size);
+    break;
+  case KrustyBusEvent::KB_FLUSH:
+    break;
+  case KrustyBusEvent::KB_MEMCPY:
+  case KrustyBusEvent::KB_MEMSET:
+  case KrustyBusEvent::KB_GATHER:
+  case KrustyBusEvent::KB_SCATTER:
+    R.Len = kev->getLen();
+    startBulk(R);
+    return;
+  default:
+    out.fatal(CALL_INFO, -1, "Error: unknown KrustyBusEvent opcode %d from %lld\n",
+              R.Opcode, (long long)(R.Src));
+    break;
+  }
+
+  if( R.Size == 0 )
+    out.fatal(CALL_INFO, -1, "Error: zero sized request to 0x%llx from %lld\n",
+              (unsigned long long)(R.Addr), (long long)(R.Src));
+  enqueueReq(R);
+}
+
+void KrustyMem::enqueueReq(KrustyMemReq &R){
+  if( !findRegion(R.Addr, R.Len, R.Region) )
+    out.fatal(CALL_INFO, -1, "Error: request to 0x%llx (size=%llu) is not mapped to a single region\n",
+              (unsigned long long)(R.Addr), (unsigned long long)(R.Len));
+
+  R.Ready = getCurrentSimTime(clockTC) + Regions[R.Region].Latency;
+  Regions[R.Region].pendQ.push_back(R);
+}
+
+uint64_t KrustyMem::chunkLen(uint64_t Addr, uint64_t Remain){
+  uint64_t Len = std::min(Remain, BulkChunk - (Addr % BulkChunk));
+  unsigned Region;
+  if( findRegion(Addr, 1, Region) && (Regions[Region].End - Addr) < Len )
+    Len = Regions[Region].End - Addr + 1;
+  return Len;
+}
+
+void KrustyMem::startBulk(KrustyMemReq &R){
+  KrustyMemBulk B;
+  B.Req       = R;
+  B.Total     = R.Len;
+  B.Started   = 0;
+  B.Completed = 0;
+  B.Inflight  = 0;
+
+  switch( R.Opcode ){
+  case KrustyBusEvent::KB_MEMSET:
+    if( R.Size == 0 )
+      B.Req.Size = 1;
+    // fall through
+  case KrustyBusEvent::KB_GATHER:
+  case KrustyBusEvent::KB_SCATTER:
+    if( B.Req.Size == 0 || B.Req.Size > sizeof(uint64_t) )
+      out.fatal(CALL_INFO, -1, "Error: bulk element size %d is not between 1 and 8 bytes\n", R.Size);
+    break;
+  default:
+    break;
+  }
+
+  out.verbose(CALL_INFO, 9, 0, "Starting bulk opcode=%d addr=0x%llx len=%llu from %lld\n",
+              R.Opcode, (unsigned long long)(R.Addr), (unsigned long long)(R.Len),
+              (long long)(R.Src));
+
+  // completion, including zero length operations, is detected in clock()
+  bulkOps[nextBulk++] = B;
+}
+
+void KrustyMem::startBulkUnit(uint64_t Id, KrustyMemBulk &B){
+  KrustyMemReq R;
+  R.Opcode  = KrustyBusEvent::KB_READ;
+  R.Size    = 0;
+  R.Data    = 0;
+  R.Index   = 0;
+  R.Region  = 0;
+  R.Src     = B.Req.Src;
+  R.Arrival = getCurrentSimTime(clockTC);
+  R.Seq     = B.Req.Seq;
+  R.Bulk    = Id;
+  R.Target  = 0;
+
+  uint64_t Remain = B.Total - B.Started;
+
+  switch( B.Req.Opcode ){
+  case KrustyBusEvent::KB_MEMCPY:
+    // read a chunk of the source; the response is stored to the destination
+    R.Unit   = B.Started;
+    R.Addr   = B.Req.Data + R.Unit;
+    R.Target = B.Req.Addr + R.Unit;
+    R.Len    = std::min(chunkLen(R.Addr, Remain), chunkLen(R.Target, Remain));
+    R.Stage  = KM_STAGE_LOAD;
+    B.Started += R.Len;
+    break;
+  case KrustyBusEvent::KB_MEMSET:
+    // write a chunk of the replicated fill pattern
+    R.Opcode = KrustyBusEvent::KB_WRITE;
+    R.Unit   = B.Started;
+    R.Addr   = B.Req.Addr + R.Unit;
+    R.Len    = chunkLen(R.Addr, Remain);
+    R.Stage  = KM_STAGE_STORE;
+    R.Buf.resize(R.Len);
+    for( uint64_t i=0; i<R.Len; i++ )
+      R.Buf[i] = (uint8_t)((B.Req.Data >> (8*((R.Unit + i) % B.Req.Size))) & 0xFF);
+    B.Started += R.Len;
+    break;
+  case KrustyBusEvent::KB_GATHER:
+  case KrustyBusEvent::KB_SCATTER:
+    // read the next 64-bit index
+    R.Unit   = B.Started;
+    R.Addr   = B.Req.Index + R.Unit * sizeof(uint64_t);
+    R.Len    = sizeof(uint64_t);
+    R.Stage  = KM_STAGE_INDEX;
+    B.Started++;
+    break;
+  default:
+    out.fatal(CALL_INFO, -1, "Error: unknown bulk opcode %d\n", B.Req.Opcode);
+    break;
+  }
+
+  B.Inflight++;
+  enqueueReq(R);
+}
+
+void KrustyMem::advanceBulk(KrustyMemReq &R){
+  auto it = bulkOps.find(R.Bulk);
+  if( it == bulkOps.end() )
+    out.fatal(CALL_INFO, -1, "Error: memory response for unknown bulk operation %llu\n",
+              (unsigned long long)(R.Bulk));
+  KrustyMemBulk &B = it->second;
+  uint64_t ElemSize = B.Req.Size;
+
+  switch( R.Stage ){
+  case KM_STAGE_INDEX:{
+    uint64_t Idx = 0;
+    for( unsigned i=0; i<R.Buf.size() && i<sizeof(uint64_t); i++ )
+      Idx |= ((uint64_t)(R.Buf[i])) << (8*i);
+    uint64_t ElemAddr = B.Req.Addr + Idx * ElemSize;
+    uint64_t BufAddr  = B.Req.Data + R.Unit * ElemSize;
+    R.Addr   = (B.Req.Opcode == KrustyBusEvent::KB_GATHER) ? ElemAddr : BufAddr;
+    R.Target = (B.Req.Opcode == KrustyBusEvent::KB_GATHER) ? BufAddr : ElemAddr;
+    R.Len    = ElemSize;
+    R.Stage  = KM_STAGE_LOAD;
+    R.Buf.clear();
+    R.Arrival = getCurrentSimTime(clockTC);
+    enqueueReq(R);
+    break;
+  }
+  case KM_STAGE_LOAD:
+    R.Opcode = KrustyBusEvent::KB_WRITE;
+    R.Addr   = R.Target;
+    R.Stage  = KM_STAGE_STORE;
+    R.Arrival = getCurrentSimTime(clockTC);
+    enqueueReq(R);
+    break;
+  case KM_STAGE_STORE:
+    B.Inflight--;
+    if( B.Req.Opcode == KrustyBusEvent::KB_MEMCPY || B.Req.Opcode == KrustyBusEvent::KB_MEMSET )
+      B.Completed += R.Len;
+    else
+      B.Completed++;
+    break;
+  default:
+    out.fatal(CALL_INFO, -1, "Error: unknown bulk stage %d\n", R.Stage);
+    break;
+  }
+}
+
+SST::Interfaces::StandardMem::Request* KrustyMem::buildReq(KrustyMemReq &R){
+  switch( R.Opcode ){
+  case KrustyBusEvent::KB_READ:
+    return new SST::Interfaces::StandardMem::Read(R.Addr, R.Len);
+  case KrustyBusEvent::KB_WRITE:
+    // host writes carry their payload in the event data field
+    if( R.Bulk == 0 ){
+      R.Buf.resize(R.Len);
+      for( unsigned i=0; i<R.Len; i++ )
+        R.Buf[i] = (uint8_t)((R.Data >> (8*i)) & 0xFF);
+    }
+    return new SST::Interfaces::StandardMem::Write(R.Addr, R.Len, R.Buf);
+  case KrustyBusEvent::KB_FLUSH:
+    return new SST::Interfaces::StandardMem::FlushAddr(R.Addr, R.Size, false,
+                                                       std::numeric_limits<uint32_t>::max());
+  default:
+    out.fatal(CALL_INFO, -1, "Error: cannot issue opcode %d to memory\n", R.Opcode);
+    break;
+  }
+  return nullptr;
+}
+
+void KrustyMem::issueReq(KrustyMemReq &R){
+  KrustyMemRegion &Reg = Regions[R.Region];
+
+  // requests restored from a checkpoint keep their original ids so the
+  // backend's restored responses still match them.  The id counter is
+  // not checkpointed and restarts, so skip any id that is still in use.
+  SST::Interfaces::StandardMem::Request *req = buildReq(R);
+  while( outstanding.count(req->getID()) ){
+    delete req;
+    req = buildReq(R);
+  }
+
+  switch( R.Opcode ){
+  case KrustyBusEvent::KB_READ:
+    Reg.ReadReqs->addData(1);
+    Reg.BytesRead->addData(R.Len);
+    break;
+  case KrustyBusEvent::KB_WRITE:
+    Reg.WriteReqs->addData(1);
+    Reg.BytesWritten->addData(R.Len);
+    break;
+  case KrustyBusEvent::KB_FLUSH:
+    Reg.FlushReqs->addData(1);
+    break;
+  }
+
+  out.verbose(CALL_INFO, 10, 0, "Issued opcode=%d addr=0x%llx to %s\n",
+              R.Opcode, (unsigned long long)(R.Addr), Reg.Type.c_str());
+  outstanding[req->getID()] = R;
+  Reg.Mem->send(req);
+}
+
+void KrustyMem::handleMemResp(SST::Interfaces::StandardMem::Request *req){
+  auto it = outstanding.find(req->getID());
+  if( it == outstanding.end() )
+    out.fatal(CALL_INFO, -1, "Error: received a memory response with no matching request\n");
+
+  KrustyMemReq R = it->second;
+  outstanding.erase(it);
+
+  SST::Interfaces::StandardMem::ReadResp *resp =
+    dynamic_cast<SST::Interfaces::StandardMem::ReadResp*>(req);
+  if( resp && R.Bulk != 0 ){
+    R.Buf = resp->data;
+  }else if( resp ){
+    R.Data = 0;
+    for( unsigned i=0; i<resp->data.size() && i<sizeof(uint64_t); i++ )
+      R.Data |= ((uint64_t)(resp->data[i])) << (8*i);
+  }
+
+  Regions[R.Region].ReqLatency->addData(getCurrentSimTime(clockTC) - R.Arrival);
+  if( R.Bulk != 0 )
+    advanceBulk(R);
+  else
+    sendResponse(R);
+  delete req;
+}
+
+void KrustyMem::sendResponse(const KrustyMemReq &R){
+  auto it = inflight.find(R.Src);
+  if( it != inflight.end() ){
+    it->second.erase(R.Seq);
+    if( it->second.empty() )
+      inflight.erase(it);
+  }
+
+  KrustyBusEvent *ev = new KrustyBusEvent();
+  ev->setOpcode(R.Opcode);
+  ev->setSize(R.Size);
+  ev->setAddr(R.Addr);
+  ev->setData(R.Data);
+  ev->setLen(R.Len);
+  ev->setIndex(R.Index);
+  ev->setType(KB_MEM);
+  ev->setSrc(Nic->getAddress());
+  Nic->send(ev, R.Src);
+}
+
+bool KrustyMem::fenceReady(const KrustyMemReq &F){
+  auto it = inflight.find(F.Src);
+  return (it == inflight.end()) || (*it->second.begin() > F.Seq);
+}
+
+bool KrustyMem::clock(SST::Cycle_t cycle){
+  SimTime_t Now = getCurrentSimTime(clockTC);
+
+  // expand the bulk operations, acknowledging each once it completes
+  for( auto it = bulkOps.begin(); it != bulkOps.end(); ){
+    KrustyMemBulk &B = it->second;
+    while( B.Inflight < BulkDepth && B.Started < B.Total )
+      startBulkUnit(it->first, B);
+    if( B.Completed == B.Total ){
+      BulkOps->addData(1);
+      BulkLatency->addData(Now - B.Req.Arrival);
+      sendResponse(B.Req);
+      it = bulkOps.erase(it);
+    }else{
+      ++it;
+    }
+  }
+
+  // issue the shaped requests from each region.  Each cycle adds
+  // Bandwidth bytes of credit, capped at one cycle's worth so an idle
+  // region cannot bank a burst; a request may issue while any credit
+  // remains and is charged its full size, so requests larger than the
+  // per-cycle budget borrow against the following cycles
+  for( auto &Reg : Regions ){
+    if( Reg.Bandwidth != 0 )
+      Reg.Credits = std::min(Reg.Credits + (int64_t)(Reg.Bandwidth), (int64_t)(Reg.Bandwidth));
+    while( !Reg.pendQ.empty() && Reg.pendQ.front().Ready <= Now &&
+           (Reg.Bandwidth == 0 || Reg.Credits > 0) ){
+      if( Reg.Bandwidth != 0 )
+        Reg.Credits -= (int64_t)(Reg.pendQ.front().Len);
+      issueReq(Reg.pendQ.front());
+      Reg.pendQ.pop_front();
+    }
+  }
+
+  // fences are acknowledged once every earlier request from the
+  // same source has been answered
+  for( auto it = fenceQ.begin(); it != fenceQ.end(); ){
+    if( fenceReady(*it) ){
+      sendResponse(*it);
+      it = fenceQ.erase(it);
+    }else{
+      ++it;
+    }
+  }
+
+  return false;
+}
 
 // EOF
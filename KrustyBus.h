@@ -24,7 +24,13 @@
 
 // -- CXX Headers
 #include <queue>
+#include <deque>
 #include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <limits>
 
 namespace SST {
 namespace KrustyBus {
@@ -48,16 +54,27 @@ typedef enum{
 class KrustyBusEvent : public SST::Event{
 public:
 
+  // Bulk operands: Addr, Data and Index are all memory addresses for the
+  // bulk opcodes.  Len counts bytes for memcpy/memset and elements for
+  // gather/scatter.  Size is the element (or fill pattern) width in
+  // bytes, 1-8.  The index array holds one unsigned little-endian 64-bit
+  // element index per element; element i lives at Addr + Index[i]*Size.
+  // Each bulk operation is acknowledged with a single response once all
+  // of its stores have completed.
   typedef enum{
     KB_UNK    = 0x00,
     KB_READ   = 0x01,
     KB_WRITE  = 0x02,
     KB_FLUSH  = 0x03,
-    KB_FENCE  = 0x04
+    KB_FENCE  = 0x04,
+    KB_MEMCPY = 0x05,   ///< copy Len bytes from address Data (src) to address Addr (dst); Size, Index unused
+    KB_MEMSET = 0x06,   ///< fill Len bytes at Addr by repeating the low Size bytes (default 1) of the Data value; Index unused
+    KB_GATHER = 0x07,   ///< for i < Len: Size bytes at Addr + Index[i]*Size are copied to Data + i*Size
+    KB_SCATTER= 0x08    ///< for i < Len: Size bytes at Data + i*Size are copied to Addr + Index[i]*Size
   }KBOpcode;
 
   /// KrustyBusEvent: default constructor
-  KrustyBusEvent() : Event() { }
+  KrustyBusEvent() : Event(), Len(0), Index(0), SendTime(0), NetLatency(0) { }
 
   /// KrustyBusEvent: retrieve the opcode
   uint8_t getOpcode() { return Opcode; }
@@ -71,6 +88,18 @@ public:
   /// KrustyBusEvent: retrieve the data
   uint64_t getData() { return Data; }
 
+  /// KrustyBusEvent: retrieve the bulk operation length
+  uint64_t getLen() { return Len; }
+
+  /// KrustyBusEvent: retrieve the bulk operation index array address
+  uint64_t getIndex() { return Index; }
+
+  /// KrustyBusEvent: retrieve the time (ps) the sending NIC accepted the event
+  uint64_t getSendTime() { return SendTime; }
+
+  /// KrustyBusEvent: retrieve the modeled network latency (ps) of a bypassed event
+  uint64_t getNetLatency() { return NetLatency; }
+
   /// KrustyBusEvent: retrieve the src ID
   SST::Interfaces::SimpleNetwork::nid_t getSrc() { return Src; }
 
@@ -89,6 +118,18 @@ public:
   /// KrustyBusEvent: set the data
   void setData(uint64_t D){ Data = D; }
 
+  /// KrustyBusEvent: set the bulk operation length
+  void setLen(uint64_t L){ Len = L; }
+
+  /// KrustyBusEvent: set the bulk operation index array address
+  void setIndex(uint64_t I){ Index = I; }
+
+  /// KrustyBusEvent: set the time (ps) the sending NIC accepted the event
+  void setSendTime(uint64_t T){ SendTime = T; }
+
+  /// KrustyBusEvent: set the modeled network latency (ps) of a bypassed event
+  void setNetLatency(uint64_t L){ NetLatency = L; }
+
   /// KrustyBusEvent: set the source
   void setSrc(SST::Interfaces::SimpleNetwork::nid_t s) { Src = s; }
 
@@ -103,10 +144,14 @@ public:
 
 private:
   uint8_t Opcode;       ///< KrustyBusEvent: opcode
-  uint8_t Size;         ///< KrustyBusEvent: size of the request
+  uint8_t Size;         ///< KrustyBusEvent: size of the request; element size in bytes for bulk operations
   uint8_t Type;         ///< KrustyBusEvent: defines the endpoint type: KBEndpoint
-  uint64_t Addr;        ///< KrustyBusEvent: address of the request
-  uint64_t Data;        ///< KrustyBusEvent: data for the event
+  uint64_t Addr;        ///< KrustyBusEvent: address of the request; destination or element base for bulk operations
+  uint64_t Data;        ///< KrustyBusEvent: data for the event; source or dense buffer address for bulk operations
+  uint64_t Len;         ///< KrustyBusEvent: length of a bulk operation (bytes for memcpy/memset, elements for gather/scatter)
+  uint64_t Index;       ///< KrustyBusEvent: address of the 64-bit element index array for gather/scatter
+  uint64_t SendTime;    ///< KrustyBusEvent: time (ps) the sending NIC accepted the event
+  uint64_t NetLatency;  ///< KrustyBusEvent: modeled network latency (ps) of a bypassed event
   SST::Interfaces::SimpleNetwork::nid_t Src;  ///< KrustyBusEvent: src id
 
 public:
@@ -114,8 +159,13 @@ public:
     Event::serialize_order(ser);
     ser &Opcode;
     ser &Size;
+    ser &Type;
     ser &Addr;
     ser &Data;
+    ser &Len;
+    ser &Index;
+    ser &SendTime;
+    ser &NetLatency;
     ser &Src;
    }
 
@@ -124,6 +174,90 @@ public:
 
 };  // end KrustyBusEvent
 
+// --------------------------------------------
+// KrustyBus Latency Model
+//
+// Analytical NIC-to-NIC latency model used in
+// place of Merlin during fast-forward windows.
+// The sending NIC refits it from the latencies
+// its peer measured in each detailed window
+// --------------------------------------------
+class KrustyBusModel : public SST::Core::Serialization::serializable{
+public:
+  uint64_t SumLat;        ///< KrustyBusModel: latency observed in the sampled detailed window
+  uint64_t Samples;       ///< KrustyBusModel: packets observed in the sampled detailed window
+  uint64_t Window;        ///< KrustyBusModel: window the samples were taken in
+  uint64_t Fit;           ///< KrustyBusModel: fitted latency
+  bool Valid;             ///< KrustyBusModel: has the model been fitted?
+
+  /// KrustyBusModel: default constructor
+  KrustyBusModel() : SumLat(0), Samples(0), Window(0), Fit(0), Valid(false) {}
+
+  /// KrustyBusModel: record a latency observed in the detailed part of window W
+  void sample(uint64_t Lat, uint64_t W){
+    SumLat += Lat;
+    Samples++;
+    Window = W;
+  }
+
+  /// KrustyBusModel: refit from the sampled window; returns true and the
+  /// percent error of the previous fit if it could be evaluated
+  bool refit(uint64_t &Error){
+    if( Samples == 0 )
+      return false;
+    uint64_t Observed = SumLat / Samples;
+    bool Scored = Valid && (Observed != 0);
+    if( Scored )
+      Error = ((Observed > Fit) ? (Observed - Fit) : (Fit - Observed)) * 100 / Observed;
+    Fit = Observed;
+    Valid = true;
+    SumLat = 0;
+    Samples = 0;
+    return Scored;
+  }
+
+  /// KrustyBusModel: serializer
+  void serialize_order(SST::Core::Serialization::serializer &ser) override{
+    ser &SumLat;
+    ser &Samples;
+    ser &Window;
+    ser &Fit;
+    ser &Valid;
+  }
+
+  /// KrustyBusModel: implement the model serialization
+  ImplementSerializable(SST::KrustyBus::KrustyBusModel);
+};  // end KrustyBusModel
+
+// --------------------------------------------
+// KrustyBus Receive Slot
+//
+// A packet from a bypass peer waiting to be
+// handed to the parent.  Packets from a peer
+// are delivered in the order they arrived,
+// which is the order the peer sent them
+// --------------------------------------------
+class KrustyBusRx : public SST::Core::Serialization::serializable{
+public:
+  KrustyBusEvent *Ev;     ///< KrustyBusRx: received packet
+  bool Ready;             ///< KrustyBusRx: has the packet's latency elapsed?
+
+  /// KrustyBusRx: default constructor
+  KrustyBusRx() : Ev(nullptr), Ready(false) {}
+
+  /// KrustyBusRx: constructor
+  KrustyBusRx(KrustyBusEvent *E, bool R) : Ev(E), Ready(R) {}
+
+  /// KrustyBusRx: serializer
+  void serialize_order(SST::Core::Serialization::serializer &ser) override{
+    ser &Ev;
+    ser &Ready;
+  }
+
+  /// KrustyBusRx: implement the slot serialization
+  ImplementSerializable(SST::KrustyBus::KrustyBusRx);
+};  // end KrustyBusRx
+
 // --------------------------------------------
 // KrustyBus NIC API
 //
@@ -137,9 +271,20 @@ public:
   /// KrustyBusNicAPI: default constructor
   KrustyBusNicAPI(ComponentId_t id, Params& params) : SubComponent(id) {}
 
+  /// KrustyBusNicAPI: checkpoint restart constructor
+  KrustyBusNicAPI() : SubComponent() {}
+
   /// KrustyBusNicAPI: default destructor
   ~KrustyBusNicAPI() {}
 
+  /// KrustyBusNicAPI: serializer
+  void serialize_order(SST::Core::Serialization::serializer &ser) override{
+    SubComponent::serialize_order(ser);
+  }
+
+  /// KrustyBusNicAPI: implement the api serialization
+  ImplementVirtualSerializable(SST::KrustyBus::KrustyBusNicAPI);
+
   /// KrustyBusNicAPI: registers the event handler with the core
   virtual void setMsgHandler(Event::HandlerBase* handler) = 0;
 
@@ -178,16 +323,23 @@ public:
     SST::KrustyBus::KrustyBusNicAPI
   )
 
+  SST_ELI_IS_CHECKPOINTABLE()
+
   // Register the parameters
   SST_ELI_DOCUMENT_PARAMS(
     {"clockFreq",   "Frequency of period (with units) of the clock", "1GHz" },
     {"port", "Port to use, if loaded as an anonymous subcomponent", "network"},
-    {"verbose", "Verbosity for output (0 = nothing)", "0"}
+    {"verbose", "Verbosity for output (0 = nothing)", "0"},
+    {"injectWidth", "Maximum number of packets injected per cycle (0 = unlimited)", "0"},
+    {"eventDriven", "Inject directly from send() when the NIC is idle", "0"},
+    {"sampleDetailed", "Cycles per detailed window when sampling is enabled", "100000"},
+    {"sampleFastForward", "Cycles per fast-forward window (0 = always detailed); packets to peers on a bypass port skip Merlin in these windows", "0"}
   )
 
   // Register the ports
   SST_ELI_DOCUMENT_PORTS(
-    {"network", "Port to network", {"simpleNetworkExample.nicEvent"} }
+    {"network", "Port to network", {"simpleNetworkExample.nicEvent"} },
+    {"bypass%(num)d", "Direct links to peer NICs, numbered from 0, used in place of Merlin during fast-forward windows", {"KrustyBus.KrustyBusEvent"} }
   )
 
   // Register the subcomponent slots
@@ -196,12 +348,16 @@ public:
   )
 
   SST_ELI_DOCUMENT_STATISTICS(
-  // none defined
+    {"BypassPkts", "Packets sent around Merlin on a bypass link", "count", 1},
+    {"ModelError", "Percent error of the network latency model against the next detailed window", "percent", 1}
   )
 
   /// KrustyBusIFace: defualt constuctor
   KrustyBusIFace(ComponentId_t id, Params& params);
 
+  /// KrustyBusIFace: checkpoint restart constructor
+  KrustyBusIFace() : KrustyBusNicAPI() {}
+
   /// KrustyBusIFace: default destructor
   ~KrustyBusIFace();
 
@@ -229,18 +385,87 @@ public:
   /// KrustyBusIFace: clock function
   virtual bool clock(Cycle_t cycle);
 
+  /// KrustyBusIFace: serializer
+  void serialize_order(SST::Core::Serialization::serializer &ser) override;
+
+  /// KrustyBusIFace: implement the nic serialization
+  ImplementSerializable(SST::KrustyBus::KrustyBusIFace);
+
 protected:
   SST::Output out;                        ///< KrustyBusIFace: SST output object
   SST::Interfaces::SimpleNetwork * iFace; ///< KrustyBusIFace: SST network interface
   SST::Event::HandlerBase *msgHandler;    ///< KrustyBusIFace: SST message handler
   bool initBroadcastSent;                 ///< KrustyBusIFace: Has the init bcast message been sent?
   int numDest;                            ///< KrustyBusIFace: number of SST destinations
-  std::queue<SST::Interfaces::SimpleNetwork::Request*> sendQ; ///< KrustyBusIFace: buffered send queue
+  std::deque<SST::Interfaces::SimpleNetwork::Request*> sendQ; ///< KrustyBusIFace: buffered send queue
   std::map<SST::Interfaces::SimpleNetwork::nid_t,uint8_t> endpointTypes;  ///<KrustyBusIFace: map of nid_t to endpoint type
 
 private:
+  /// KrustyBusIFace: returns true if the injection width allows another packet this cycle
+  bool canIssue();
+
+  /// KrustyBusIFace: attempt to inject a single packet into the network
+  bool issue(SST::Interfaces::SimpleNetwork::Request *req);
+
+  /// KrustyBusIFace: re-enable the clock handler if it has been gated off
+  void wakeClock();
+
+  /// KrustyBusIFace: deferred clock wakeup delivered on the self link
+  void handleWake(SST::Event *ev);
+
+  /// KrustyBusIFace: callback when the network has room to send again
+  bool spaceNotify(int virtualNetwork);
+
+  /// KrustyBusIFace: returns true during a fast-forward window, and the index of the current window
+  bool inFastForward(uint64_t &Window);
+
+  /// KrustyBusIFace: returns true during a fast-forward window
+  bool inFastForward();
+
+  /// KrustyBusIFace: refit the models whose detailed window has closed
+  void syncModels();
+
+  /// KrustyBusIFace: modeled Merlin latency (ps) to Dest; returns false if there is no fitted model
+  bool predictLatency(SST::Interfaces::SimpleNetwork::nid_t Dest, uint64_t &Lat);
+
+  /// KrustyBusIFace: handle a packet arriving on a bypass link
+  void handleBypass(SST::Event *ev);
+
+  /// KrustyBusIFace: mark the oldest bypassed packet from a peer ready once its modeled latency has elapsed
+  void handleDeliver(SST::Event *ev);
+
+  /// KrustyBusIFace: return a bypass credit, carrying the measured latency, for a packet that came through Merlin
+  void sendCredit(KrustyBusEvent *ev);
+
+  /// KrustyBusIFace: hand the ready packets at the head of a peer's receive queue to the parent
+  void drainRx(SST::Interfaces::SimpleNetwork::nid_t Src);
+
   // Parameters
   std::string ClockFreq;      ///< KrustyBusIFace: clock frequency
+  unsigned InjectWidth;       ///< KrustyBusIFace: maximum packets injected per cycle
+  bool EventDriven;           ///< KrustyBusIFace: inject directly from send() when idle
+
+  TimeConverter *clockTC;             ///< KrustyBusIFace: clock time converter
+  Clock::HandlerBase *clockHandler;   ///< KrustyBusIFace: clock handler
+  bool clockOn;                       ///< KrustyBusIFace: is the clock handler registered?
+  SST::Link *wakeLink;                ///< KrustyBusIFace: self link used to wake the clock
+  bool wakePending;                   ///< KrustyBusIFace: is a wakeup in flight on wakeLink?
+  SimTime_t issueCycle;               ///< KrustyBusIFace: cycle of the most recent injection
+  unsigned issued;                    ///< KrustyBusIFace: packets injected during issueCycle
+
+  uint64_t SampleDetailed;            ///< KrustyBusIFace: cycles per detailed window
+  uint64_t SampleFF;                  ///< KrustyBusIFace: cycles per fast-forward window (0 = disabled)
+  TimeConverter *psTC;                ///< KrustyBusIFace: picosecond time converter for latencies
+  SST::Link *deliverLink;             ///< KrustyBusIFace: self link delaying bypassed packets
+  std::vector<SST::Link*> bypassPorts;  ///< KrustyBusIFace: connected bypass links
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, SST::Link*> bypassLinks;  ///< KrustyBusIFace: bypass link for each peer
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, KrustyBusModel> netModels; ///< KrustyBusIFace: Merlin latency model to each bypass peer
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, uint64_t> merlinOut;  ///< KrustyBusIFace: packets to each bypass peer not yet credited
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, std::deque<KrustyBusRx>> rxQ; ///< KrustyBusIFace: packets from each bypass peer awaiting delivery
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, SimTime_t> lastDeliver; ///< KrustyBusIFace: latest bypass delivery time (ps) from each peer
+
+  Statistic<uint64_t> *BypassPkts;    ///< KrustyBusIFace: packets sent on a bypass link
+  Statistic<uint64_t> *ModelError;    ///< KrustyBusIFace: latency model percent error
 
 };  // end KrustyBusIFace
 
@@ -263,16 +488,23 @@ public:
     SST::KrustyBus::KrustyBusNicAPI
   )
 
+  SST_ELI_IS_CHECKPOINTABLE()
+
   // Register the parameters
   SST_ELI_DOCUMENT_PARAMS(
     {"clockFreq",   "Frequency of period (with units) of the clock", "1GHz" },
     {"port", "Port to use, if loaded as an anonymous subcomponent", "network"},
-    {"verbose", "Verbosity for output (0 = nothing)", "0"}
+    {"verbose", "Verbosity for output (0 = nothing)", "0"},
+    {"injectWidth", "Maximum number of packets injected per cycle (0 = unlimited)", "0"},
+    {"eventDriven", "Inject directly from send() when the NIC is idle", "0"},
+    {"sampleDetailed", "Cycles per detailed window when sampling is enabled", "100000"},
+    {"sampleFastForward", "Cycles per fast-forward window (0 = always detailed); packets to peers on a bypass port skip Merlin in these windows", "0"}
   )
 
   // Register the ports
   SST_ELI_DOCUMENT_PORTS(
-    {"network", "Port to network", {"simpleNetworkExample.nicEvent"} }
+    {"network", "Port to network", {"simpleNetworkExample.nicEvent"} },
+    {"bypass%(num)d", "Direct links to peer NICs, numbered from 0, used in place of Merlin during fast-forward windows", {"KrustyBus.KrustyBusEvent"} }
   )
 
   // Register the subcomponent slots
@@ -281,12 +513,16 @@ public:
   )
 
   SST_ELI_DOCUMENT_STATISTICS(
-  // none defined
+    {"BypassPkts", "Packets sent around Merlin on a bypass link", "count", 1},
+    {"ModelError", "Percent error of the network latency model against the next detailed window", "percent", 1}
   )
 
   /// KrustyBusMemIFace: defualt constuctor
   KrustyBusMemIFace(ComponentId_t id, Params& params);
 
+  /// KrustyBusMemIFace: checkpoint restart constructor
+  KrustyBusMemIFace() : KrustyBusNicAPI() {}
+
   /// KrustyBusMemIFace: default destructor
   ~KrustyBusMemIFace();
 
@@ -314,21 +550,225 @@ public:
   /// KrustyBusMemIFace: clock function
   virtual bool clock(Cycle_t cycle);
 
+  /// KrustyBusMemIFace: serializer
+  void serialize_order(SST::Core::Serialization::serializer &ser) override;
+
+  /// KrustyBusMemIFace: implement the nic serialization
+  ImplementSerializable(SST::KrustyBus::KrustyBusMemIFace);
+
 protected:
   SST::Output out;                        ///< KrustyBusMemIFace: SST output object
   SST::Interfaces::SimpleNetwork * iFace; ///< KrustyBusMemIFace: SST network interface
   SST::Event::HandlerBase *msgHandler;    ///< KrustyBusMemIFace: SST message handler
   bool initBroadcastSent;                 ///< KrustyBusMemIFace: Has the init bcast message been sent?
   int numDest;                            ///< KrustyBusMemIFace: number of SST destinations
-  std::queue<SST::Interfaces::SimpleNetwork::Request*> sendQ; ///< KrustyBusMemIFace: buffered send queue
+  std::deque<SST::Interfaces::SimpleNetwork::Request*> sendQ; ///< KrustyBusMemIFace: buffered send queue
   std::map<SST::Interfaces::SimpleNetwork::nid_t,uint8_t> endpointTypes;  ///<KrustyBusMemIFace: map of nid_t to endpoint type
 
 private:
+  /// KrustyBusMemIFace: returns true if the injection width allows another packet this cycle
+  bool canIssue();
+
+  /// KrustyBusMemIFace: attempt to inject a single packet into the network
+  bool issue(SST::Interfaces::SimpleNetwork::Request *req);
+
+  /// KrustyBusMemIFace: re-enable the clock handler if it has been gated off
+  void wakeClock();
+
+  /// KrustyBusMemIFace: deferred clock wakeup delivered on the self link
+  void handleWake(SST::Event *ev);
+
+  /// KrustyBusMemIFace: callback when the network has room to send again
+  bool spaceNotify(int virtualNetwork);
+
+  /// KrustyBusMemIFace: returns true during a fast-forward window, and the index of the current window
+  bool inFastForward(uint64_t &Window);
+
+  /// KrustyBusMemIFace: returns true during a fast-forward window
+  bool inFastForward();
+
+  /// KrustyBusMemIFace: refit the models whose detailed window has closed
+  void syncModels();
+
+  /// KrustyBusMemIFace: modeled Merlin latency (ps) to Dest; returns false if there is no fitted model
+  bool predictLatency(SST::Interfaces::SimpleNetwork::nid_t Dest, uint64_t &Lat);
+
+  /// KrustyBusMemIFace: handle a packet arriving on a bypass link
+  void handleBypass(SST::Event *ev);
+
+  /// KrustyBusMemIFace: mark the oldest bypassed packet from a peer ready once its modeled latency has elapsed
+  void handleDeliver(SST::Event *ev);
+
+  /// KrustyBusMemIFace: return a bypass credit, carrying the measured latency, for a packet that came through Merlin
+  void sendCredit(KrustyBusEvent *ev);
+
+  /// KrustyBusMemIFace: hand the ready packets at the head of a peer's receive queue to the parent
+  void drainRx(SST::Interfaces::SimpleNetwork::nid_t Src);
+
   // Parameters
   std::string ClockFreq;      ///< KrustyBusMemIFace: clock frequency
+  unsigned InjectWidth;       ///< KrustyBusMemIFace: maximum packets injected per cycle
+  bool EventDriven;           ///< KrustyBusMemIFace: inject directly from send() when idle
+
+  TimeConverter *clockTC;             ///< KrustyBusMemIFace: clock time converter
+  Clock::HandlerBase *clockHandler;   ///< KrustyBusMemIFace: clock handler
+  bool clockOn;                       ///< KrustyBusMemIFace: is the clock handler registered?
+  SST::Link *wakeLink;                ///< KrustyBusMemIFace: self link used to wake the clock
+  bool wakePending;                   ///< KrustyBusMemIFace: is a wakeup in flight on wakeLink?
+  SimTime_t issueCycle;               ///< KrustyBusMemIFace: cycle of the most recent injection
+  unsigned issued;                    ///< KrustyBusMemIFace: packets injected during issueCycle
+
+  uint64_t SampleDetailed;            ///< KrustyBusMemIFace: cycles per detailed window
+  uint64_t SampleFF;                  ///< KrustyBusMemIFace: cycles per fast-forward window (0 = disabled)
+  TimeConverter *psTC;                ///< KrustyBusMemIFace: picosecond time converter for latencies
+  SST::Link *deliverLink;             ///< KrustyBusMemIFace: self link delaying bypassed packets
+  std::vector<SST::Link*> bypassPorts;  ///< KrustyBusMemIFace: connected bypass links
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, SST::Link*> bypassLinks;  ///< KrustyBusMemIFace: bypass link for each peer
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, KrustyBusModel> netModels; ///< KrustyBusMemIFace: Merlin latency model to each bypass peer
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, uint64_t> merlinOut;  ///< KrustyBusMemIFace: packets to each bypass peer not yet credited
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, std::deque<KrustyBusRx>> rxQ; ///< KrustyBusMemIFace: packets from each bypass peer awaiting delivery
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, SimTime_t> lastDeliver; ///< KrustyBusMemIFace: latest bypass delivery time (ps) from each peer
+
+  Statistic<uint64_t> *BypassPkts;    ///< KrustyBusMemIFace: packets sent on a bypass link
+  Statistic<uint64_t> *ModelError;    ///< KrustyBusMemIFace: latency model percent error
 
 };  // end KrustyBusMemIFace
 
+// defines which step of a bulk operation a memory request performs
+typedef enum{
+  KM_STAGE_HOST   = 0x00,   ///< not part of a bulk operation
+  KM_STAGE_INDEX  = 0x01,   ///< gather/scatter index read
+  KM_STAGE_LOAD   = 0x02,   ///< data read feeding a later store
+  KM_STAGE_STORE  = 0x03    ///< final data write
+}KMStage;
+
+// --------------------------------------------
+// KrustyMem Request
+//
+// A single memory operation as tracked by
+// KrustyMem, from arrival on the bus through
+// issue to its region's StandardMem backend
+// --------------------------------------------
+class KrustyMemReq : public SST::Core::Serialization::serializable{
+public:
+  uint8_t Opcode;         ///< KrustyMemReq: KrustyBusEvent opcode
+  uint8_t Size;           ///< KrustyMemReq: size of the request
+  uint64_t Addr;          ///< KrustyMemReq: address of the request
+  uint64_t Data;          ///< KrustyMemReq: write data or read response data
+  uint64_t Len;           ///< KrustyMemReq: bytes accessed, or the bulk operation length
+  uint64_t Index;         ///< KrustyMemReq: gather/scatter index array address
+  unsigned Region;        ///< KrustyMemReq: index of the servicing region
+  SST::Interfaces::SimpleNetwork::nid_t Src;  ///< KrustyMemReq: requesting endpoint
+  SimTime_t Arrival;      ///< KrustyMemReq: cycle the request arrived from the bus or entered its bulk stage
+  SimTime_t Ready;        ///< KrustyMemReq: earliest cycle the request may issue
+  uint64_t Seq;           ///< KrustyMemReq: arrival order of the originating bus request
+
+  // -- bulk operation state --
+  uint64_t Bulk;          ///< KrustyMemReq: owning bulk operation (0 = host request)
+  uint8_t Stage;          ///< KrustyMemReq: bulk operation stage: KMStage
+  uint64_t Unit;          ///< KrustyMemReq: element index or byte offset within the bulk operation
+  uint64_t Target;        ///< KrustyMemReq: store address for the following stage
+  std::vector<uint8_t> Buf;   ///< KrustyMemReq: bulk read/write payload
+
+  /// KrustyMemReq: serializer
+  void serialize_order(SST::Core::Serialization::serializer &ser) override{
+    ser &Opcode;
+    ser &Size;
+    ser &Addr;
+    ser &Data;
+    ser &Len;
+    ser &Index;
+    ser &Region;
+    ser &Src;
+    ser &Arrival;
+    ser &Ready;
+    ser &Seq;
+    ser &Bulk;
+    ser &Stage;
+    ser &Unit;
+    ser &Target;
+    ser &Buf;
+  }
+
+  /// KrustyMemReq: implement the request serialization
+  ImplementSerializable(SST::KrustyBus::KrustyMemReq);
+};  // end KrustyMemReq
+
+// --------------------------------------------
+// KrustyMem Bulk Operation
+//
+// A memcpy, memset, gather or scatter request
+// that KrustyMem expands locally into a
+// pipeline of StandardMem requests
+// --------------------------------------------
+class KrustyMemBulk : public SST::Core::Serialization::serializable{
+public:
+  KrustyMemReq Req;       ///< KrustyMemBulk: originating bus request
+  uint64_t Total;         ///< KrustyMemBulk: bytes (memcpy/memset) or elements (gather/scatter)
+  uint64_t Started;       ///< KrustyMemBulk: bytes or elements issued so far
+  uint64_t Completed;     ///< KrustyMemBulk: bytes or elements stored so far
+  unsigned Inflight;      ///< KrustyMemBulk: units currently in flight
+
+  /// KrustyMemBulk: serializer
+  void serialize_order(SST::Core::Serialization::serializer &ser) override{
+    ser &Req;
+    ser &Total;
+    ser &Started;
+    ser &Completed;
+    ser &Inflight;
+  }
+
+  /// KrustyMemBulk: implement the bulk operation serialization
+  ImplementSerializable(SST::KrustyBus::KrustyMemBulk);
+};  // end KrustyMemBulk
+
+// --------------------------------------------
+// KrustyMem Region
+//
+// Maps an address range to its own StandardMem
+// backend along with the latency/bandwidth
+// shaping and statistics for that range
+// --------------------------------------------
+class KrustyMemRegion : public SST::Core::Serialization::serializable{
+public:
+  uint64_t Base;          ///< KrustyMemRegion: base address
+  uint64_t End;           ///< KrustyMemRegion: last address (inclusive)
+  std::string Type;       ///< KrustyMemRegion: backend label (DRAM, HBM, NVM, ...)
+  unsigned Latency;       ///< KrustyMemRegion: additional cycles before issue
+  uint64_t Bandwidth;     ///< KrustyMemRegion: bytes issued per cycle (0 = unlimited)
+  int64_t Credits;        ///< KrustyMemRegion: byte credits available to issue this cycle
+  SST::Interfaces::StandardMem *Mem;  ///< KrustyMemRegion: StandardMem backend
+  std::deque<KrustyMemReq> pendQ;     ///< KrustyMemRegion: requests awaiting issue
+
+  Statistic<uint64_t> *ReadReqs;      ///< KrustyMemRegion: read requests issued
+  Statistic<uint64_t> *WriteReqs;     ///< KrustyMemRegion: write requests issued
+  Statistic<uint64_t> *FlushReqs;     ///< KrustyMemRegion: flush requests issued
+  Statistic<uint64_t> *BytesRead;     ///< KrustyMemRegion: bytes read
+  Statistic<uint64_t> *BytesWritten;  ///< KrustyMemRegion: bytes written
+  Statistic<uint64_t> *ReqLatency;    ///< KrustyMemRegion: arrival to response latency
+
+  /// KrustyMemRegion: serializer
+  void serialize_order(SST::Core::Serialization::serializer &ser) override{
+    ser &Base;
+    ser &End;
+    ser &Type;
+    ser &Latency;
+    ser &Bandwidth;
+    ser &Credits;
+    ser &Mem;
+    ser &pendQ;
+    ser &ReadReqs;
+    ser &WriteReqs;
+    ser &FlushReqs;
+    ser &BytesRead;
+    ser &BytesWritten;
+    ser &ReqLatency;
+  }
+
+  /// KrustyMemRegion: implement the region serialization
+  ImplementSerializable(SST::KrustyBus::KrustyMemRegion);
+};  // end KrustyMemRegion
+
 // --------------------------------------------
 // KrustyBus Memory Interface
 //
@@ -347,9 +787,20 @@ public:
     COMPONENT_CATEGORY_MEMORY
   )
 
+  SST_ELI_IS_CHECKPOINTABLE()
+
   // document the parameters
   SST_ELI_DOCUMENT_PARAMS(
-    { "clockFreq",   "Frequency of period (with units) of the clock", "1GHz" }
+    { "clockFreq",   "Frequency of period (with units) of the clock", "1GHz" },
+    { "verbose", "Verbosity for output (0 = nothing)", "0" },
+    { "numRegions", "Number of address regions; region N uses memory slot N", "1" },
+    { "regionN.base", "Base address of region N", "0" },
+    { "regionN.size", "Size of region N in bytes (0 = to the top of the address space)", "0" },
+    { "regionN.type", "Backend label for region N (DRAM, HBM, NVM, ...)", "DRAM" },
+    { "regionN.latency", "Additional cycles before region N issues a request", "0" },
+    { "regionN.bandwidth", "Bytes region N may issue per cycle (0 = unlimited)", "0" },
+    { "bulkChunk", "Maximum bytes per request when expanding memcpy/memset", "64" },
+    { "bulkDepth", "Maximum chunks (memcpy/memset) or elements (gather/scatter, one 64-bit index read each) in flight per bulk operation", "8" }
   )
 
   // document the ports
@@ -357,11 +808,20 @@ public:
 
   // document the statistics
   SST_ELI_DOCUMENT_STATISTICS(
+    {"ReadReqs",     "Read requests issued to a region",          "count",  1},
+    {"WriteReqs",    "Write requests issued to a region",         "count",  1},
+    {"FlushReqs",    "Flush requests issued to a region",         "count",  1},
+    {"BytesRead",    "Bytes read from a region",                  "bytes",  1},
+    {"BytesWritten", "Bytes written to a region",                 "bytes",  1},
+    {"Latency",      "Cycles from bus arrival to region response", "cycles", 1},
+    {"BulkOps",      "Bulk operations completed",                 "count",  1},
+    {"BulkLatency",  "Cycles from bus arrival to bulk operation completion", "cycles", 1}
   )
 
   // document the subcomponent slots
   SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
     {"network", "Network interface", "SST::KrustyBus::KrustyBusMemIFace"},
+    {"memory", "StandardMem interface, one per region index", "SST::Interfaces::StandardMem"}
   )
 
   // -- class members --
@@ -369,6 +829,9 @@ public:
   /// KrustyMem: constructor
   KrustyMem(SST::ComponentId_t, SST::Params& params);
 
+  /// KrustyMem: checkpoint restart constructor
+  KrustyMem() : Component() {}
+
   /// KrustyMem: destructor
   ~KrustyMem();
 
@@ -379,7 +842,13 @@ public:
   void finish();
 
   /// KrustyMem: init function
-  void init();
+  void init(unsigned int phase);
+
+  /// KrustyMem: serializer
+  void serialize_order(SST::Core::Serialization::serializer &ser) override;
+
+  /// KrustyMem: implement the component serialization
+  ImplementSerializable(SST::KrustyBus::KrustyMem);
 
 private:
 
@@ -389,12 +858,65 @@ private:
   // KrustyMem: handle the incoming network message
   void handleMessage(SST::Event *ev);
 
+  /// KrustyMem: handle responses from the StandardMem backends
+  void handleMemResp(SST::Interfaces::StandardMem::Request *req);
+
+  /// KrustyMem: read and sort the region table from the params
+  void parseRegions(SST::Params& params);
+
+  /// KrustyMem: find the region containing [Addr, Addr+Size); returns false if unmapped
+  bool findRegion(uint64_t Addr, uint64_t Size, unsigned &Region);
+
+  /// KrustyMem: queue a request on its region for shaped issue
+  void enqueueReq(KrustyMemReq &R);
+
+  /// KrustyMem: issue a request to its region's StandardMem backend
+  void issueReq(KrustyMemReq &R);
+
+  /// KrustyMem: build the StandardMem request for a shaped request
+  SST::Interfaces::StandardMem::Request* buildReq(KrustyMemReq &R);
+
+  /// KrustyMem: accept a bulk operation from the bus
+  void startBulk(KrustyMemReq &R);
+
+  /// KrustyMem: issue the first stage of the next unit of a bulk operation
+  void startBulkUnit(uint64_t Id, KrustyMemBulk &B);
+
+  /// KrustyMem: move a bulk operation request on to its next stage
+  void advanceBulk(KrustyMemReq &R);
+
+  /// KrustyMem: largest access at Addr that stays within one chunk and one region
+  uint64_t chunkLen(uint64_t Addr, uint64_t Remain);
+
+  /// KrustyMem: send a response back to the requesting endpoint
+  void sendResponse(const KrustyMemReq &R);
+
+  /// KrustyMem: returns true once every earlier request from the fence's source has completed
+  bool fenceReady(const KrustyMemReq &F);
+
   /// Params
   SST::Output out;            // SST Output object for printing, messaging, etc
+  TimeConverter *clockTC;     ///< KrustyMem: clock time converter
+  uint64_t BulkChunk;         ///< KrustyMem: maximum bytes per memcpy/memset request
+  unsigned BulkDepth;         ///< KrustyMem: maximum requests in flight per bulk operation
 
   // -- subcomponents --
   KrustyBusNicAPI *Nic;       ///< KrustyBus::KrustyBusNicAPI network interface controller
 
+  // -- internal state --
+  std::vector<KrustyMemRegion> Regions;   ///< KrustyMem: region table sorted by base address
+  std::vector<uint64_t> RegionBases;      ///< KrustyMem: sorted base addresses for lookup
+  std::map<SST::Interfaces::StandardMem::Request::id_t, KrustyMemReq> outstanding; ///< KrustyMem: requests issued to the backends
+  std::deque<KrustyMemReq> fenceQ;        ///< KrustyMem: fences awaiting earlier requests from their source
+  std::map<SST::Interfaces::SimpleNetwork::nid_t, std::set<uint64_t>> inflight; ///< KrustyMem: sequence numbers of unanswered requests by source
+  uint64_t nextSeq;                       ///< KrustyMem: next arrival sequence number
+  std::map<uint64_t, KrustyMemBulk> bulkOps;  ///< KrustyMem: bulk operations in progress
+  uint64_t nextBulk;                      ///< KrustyMem: next bulk operation id
+
+  // -- statistics --
+  Statistic<uint64_t> *BulkOps;           ///< KrustyMem: bulk operations completed
+  Statistic<uint64_t> *BulkLatency;       ///< KrustyMem: bulk operation latency
+
 };  // end KrustyMem
 
 